@@ -0,0 +1,626 @@
+#pragma once
+
+#include "stdafx.h"
+#include "helper.hpp"
+
+#include <intrin.h>
+#include <algorithm>
+#include <atomic>
+#include <array>
+#include <cerrno>
+#include <safetyhook.hpp>
+
+namespace Heap
+{
+    // Blocks up to kMaxBlockSize are served from a reserved arena carved into 64KB spans.
+    // Each span belongs to a single size class. Anything bigger goes to the original heap.
+    // The requested size of every block is kept in a side table with one entry per kMinBlockSize bytes of arena.
+    constexpr std::size_t kArenaSize = 8ull << 30;
+    constexpr std::size_t kSpanShift = 16;
+    constexpr std::size_t kSpanSize = 1ull << kSpanShift;
+    constexpr std::size_t kMaxSpans = kArenaSize / kSpanSize;
+    constexpr std::size_t kNumClasses = 40;
+    constexpr std::size_t kMinBlockSize = 16;
+    constexpr std::size_t kMaxBlockSize = 32768;
+    constexpr std::size_t kSpanSizesBytes = kSpanSize / kMinBlockSize * sizeof(std::uint16_t);
+
+    // Original functions
+    using malloc_t = void* (__cdecl*)(std::size_t);
+    using calloc_t = void* (__cdecl*)(std::size_t, std::size_t);
+    using realloc_t = void* (__cdecl*)(void*, std::size_t);
+    using recalloc_t = void* (__cdecl*)(void*, std::size_t, std::size_t);
+    using expand_t = void* (__cdecl*)(void*, std::size_t);
+    using free_t = void(__cdecl*)(void*);
+    using msize_t = std::size_t(__cdecl*)(void*);
+    using crterrno_t = int* (__cdecl*)();
+    using HeapAlloc_t = LPVOID(WINAPI*)(HANDLE, DWORD, SIZE_T);
+    using RtlReAllocateHeap_t = PVOID(NTAPI*)(PVOID, ULONG, PVOID, SIZE_T);
+    using RtlFreeHeap_t = BOOLEAN(NTAPI*)(PVOID, ULONG, PVOID);
+    using RtlSizeHeap_t = SIZE_T(NTAPI*)(PVOID, ULONG, LPCVOID);
+
+    malloc_t oMalloc;
+    calloc_t oCalloc;
+    realloc_t oRealloc;
+    recalloc_t oRecalloc;
+    expand_t oExpand;
+    free_t oFree;
+    msize_t oMsize;
+    crterrno_t oErrno;
+    HeapAlloc_t oHeapAlloc;
+    RtlReAllocateHeap_t oRtlReAllocateHeap;
+    RtlFreeHeap_t oRtlFreeHeap;
+    RtlSizeHeap_t oRtlSizeHeap;
+    HANDLE hProcessHeap;
+
+    struct CentralList
+    {
+        SRWLOCK lock = SRWLOCK_INIT;
+        void* freeList = nullptr;
+        std::size_t freeCount = 0;
+        std::uint8_t* spanCursor = nullptr;
+        std::uint8_t* spanEnd = nullptr;
+
+        // Stats, only written while holding the lock
+        std::atomic<std::uint64_t> spans{ 0 };
+        std::atomic<std::uint64_t> blocksOut{ 0 };
+        std::atomic<std::uint64_t> blocksIn{ 0 };
+        std::atomic<std::uint64_t> lockAcquires{ 0 };
+        std::atomic<std::uint64_t> lockContended{ 0 };
+    };
+
+    struct alignas(64) PaddedCentralList : CentralList {};
+
+    struct ThreadCache
+    {
+        void* head[kNumClasses];
+        std::uint32_t count[kNumClasses];
+        bool bRegistered;
+    };
+
+    std::uint8_t* ArenaBase = nullptr;
+    std::uint16_t* RequestedSizes = nullptr;
+    std::atomic<std::size_t> NextSpan{ 0 };
+    std::uint8_t SpanClass[kMaxSpans];
+    std::array<std::uint32_t, kNumClasses> ClassSize;
+    std::array<std::uint32_t, kNumClasses> ClassBatch;
+    std::array<PaddedCentralList, kNumClasses> Central;
+    DWORD FlsIndex = FLS_OUT_OF_INDEXES;
+    thread_local ThreadCache tCache;
+
+    // 16-byte steps up to 128, then four steps per power of two up to 32KB
+    inline std::size_t SizeToClass(std::size_t size)
+    {
+        if (size <= 128)
+            return size ? (size - 1) / 16 : 0;
+
+        unsigned long msb;
+        _BitScanReverse64(&msb, size - 1);
+        return 8 + (msb - 7) * 4 + ((size - 1) >> (msb - 2)) - 4;
+    }
+
+    inline bool Owns(const void* ptr)
+    {
+        return ArenaBase && ptr >= ArenaBase && ptr < ArenaBase + kArenaSize;
+    }
+
+    inline std::size_t BlockClass(const void* ptr)
+    {
+        return SpanClass[((const std::uint8_t*)ptr - ArenaBase) >> kSpanShift] - 1;
+    }
+
+    // Usable size of the block's size class
+    inline std::size_t BlockCapacity(const void* ptr)
+    {
+        return ClassSize[BlockClass(ptr)];
+    }
+
+    // Size the block was last allocated or resized to
+    inline std::uint16_t& BlockSize(const void* ptr)
+    {
+        return RequestedSizes[((const std::uint8_t*)ptr - ArenaBase) / kMinBlockSize];
+    }
+
+    void LockCentral(CentralList& central)
+    {
+        if (!TryAcquireSRWLockExclusive(&central.lock)) {
+            AcquireSRWLockExclusive(&central.lock);
+            central.lockContended.fetch_add(1, std::memory_order_relaxed);
+        }
+        central.lockAcquires.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Moves up to a batch of blocks from the central list in to the thread cache
+    bool Refill(std::size_t cls)
+    {
+        auto& central = Central[cls];
+        std::uint32_t size = ClassSize[cls];
+        std::uint32_t batch = ClassBatch[cls];
+        std::uint32_t moved = 0;
+
+        LockCentral(central);
+        while (moved < batch && central.freeList) {
+            void* block = central.freeList;
+            central.freeList = *(void**)block;
+            central.freeCount--;
+            *(void**)block = tCache.head[cls];
+            tCache.head[cls] = block;
+            moved++;
+        }
+
+        while (moved < batch) {
+            if (central.spanCursor + size > central.spanEnd) {
+                std::size_t span = NextSpan.fetch_add(1, std::memory_order_relaxed);
+                if (span >= kMaxSpans)
+                    break;
+
+                std::uint8_t* spanBase = ArenaBase + (span << kSpanShift);
+                std::uint8_t* spanSizes = (std::uint8_t*)RequestedSizes + span * kSpanSizesBytes;
+                if (!VirtualAlloc(spanBase, kSpanSize, MEM_COMMIT, PAGE_READWRITE) || !VirtualAlloc(spanSizes, kSpanSizesBytes, MEM_COMMIT, PAGE_READWRITE))
+                    break;
+
+                SpanClass[span] = static_cast<std::uint8_t>(cls + 1);
+                central.spanCursor = spanBase;
+                central.spanEnd = spanBase + kSpanSize;
+                central.spans.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void* block = central.spanCursor;
+            central.spanCursor += size;
+            *(void**)block = tCache.head[cls];
+            tCache.head[cls] = block;
+            moved++;
+        }
+
+        central.blocksOut.fetch_add(moved, std::memory_order_relaxed);
+        ReleaseSRWLockExclusive(&central.lock);
+
+        tCache.count[cls] += moved;
+        return moved != 0;
+    }
+
+    // Hands count blocks from the thread cache back to the central list
+    void Release(ThreadCache& cache, std::size_t cls, std::uint32_t count)
+    {
+        if (!count)
+            return;
+
+        void* first = cache.head[cls];
+        void* last = first;
+        for (std::uint32_t i = 1; i < count; i++)
+            last = *(void**)last;
+        cache.head[cls] = *(void**)last;
+        cache.count[cls] -= count;
+
+        auto& central = Central[cls];
+        LockCentral(central);
+        *(void**)last = central.freeList;
+        central.freeList = first;
+        central.freeCount += count;
+        central.blocksIn.fetch_add(count, std::memory_order_relaxed);
+        ReleaseSRWLockExclusive(&central.lock);
+    }
+
+    // Flushes a thread's cache when the thread exits
+    void WINAPI ThreadExit(void* data)
+    {
+        if (auto cache = static_cast<ThreadCache*>(data)) {
+            for (std::size_t cls = 0; cls < kNumClasses; cls++)
+                Release(*cache, cls, cache->count[cls]);
+        }
+    }
+
+    // Registers the calling thread's cache so it gets flushed on thread exit
+    inline void RegisterThread()
+    {
+        if (!tCache.bRegistered) {
+            tCache.bRegistered = true;
+            FlsSetValue(FlsIndex, &tCache);
+        }
+    }
+
+    void* Allocate(std::size_t size)
+    {
+        std::size_t cls = SizeToClass(size);
+
+        if (!tCache.head[cls]) {
+            RegisterThread();
+            if (!Refill(cls))
+                return nullptr;
+        }
+
+        void* block = tCache.head[cls];
+        tCache.head[cls] = *(void**)block;
+        tCache.count[cls]--;
+        BlockSize(block) = static_cast<std::uint16_t>(size);
+        return block;
+    }
+
+    void Deallocate(void* ptr)
+    {
+        std::size_t cls = BlockClass(ptr);
+        RegisterThread();
+        *(void**)ptr = tCache.head[cls];
+        tCache.head[cls] = ptr;
+
+        if (++tCache.count[cls] > ClassBatch[cls] * 2)
+            Release(tCache, cls, ClassBatch[cls]);
+    }
+
+    // Moves an owned block to a new size. Keeps the same block if it still fits its size class.
+    // Sizes too large for the arena are allocated with fallback, which must match the family of the caller.
+    // With bZeroTail, bytes past the old requested size are zeroed.
+    void* Reallocate(void* ptr, std::size_t size, malloc_t fallback, bool bZeroTail = false)
+    {
+        std::size_t oldSize = BlockSize(ptr);
+        void* newPtr = ptr;
+
+        if (size <= kMaxBlockSize && SizeToClass(size) == BlockClass(ptr)) {
+            BlockSize(ptr) = static_cast<std::uint16_t>(size);
+        }
+        else {
+            newPtr = size <= kMaxBlockSize ? Allocate(size) : nullptr;
+            if (!newPtr)
+                newPtr = fallback(size);
+            if (!newPtr)
+                return nullptr;
+
+            memcpy(newPtr, ptr, (std::min)(oldSize, size));
+            Deallocate(ptr);
+        }
+
+        if (bZeroTail && size > oldSize)
+            memset((std::uint8_t*)newPtr + oldSize, 0, size - oldSize);
+        return newPtr;
+    }
+
+    // Allocation hooks, installed in the game's IAT
+    void* __cdecl Malloc_Hook(std::size_t size)
+    {
+        if (size <= kMaxBlockSize) {
+            if (void* ptr = Allocate(size))
+                return ptr;
+        }
+        return oMalloc(size);
+    }
+
+    void* __cdecl Calloc_Hook(std::size_t count, std::size_t size)
+    {
+        if (size && count > kMaxBlockSize / size)
+            return oCalloc(count, size);
+
+        if (void* ptr = Allocate(count * size)) {
+            memset(ptr, 0, count * size);
+            return ptr;
+        }
+        return oCalloc(count, size);
+    }
+
+    // Only plain allocations from the process heap are redirected
+    LPVOID WINAPI HeapAlloc_Hook(HANDLE hHeap, DWORD dwFlags, SIZE_T dwBytes)
+    {
+        if (hHeap == hProcessHeap && !(dwFlags & ~HEAP_ZERO_MEMORY) && dwBytes <= kMaxBlockSize) {
+            if (void* ptr = Allocate(dwBytes)) {
+                if (dwFlags & HEAP_ZERO_MEMORY)
+                    memset(ptr, 0, dwBytes);
+                return ptr;
+            }
+        }
+        return oHeapAlloc(hHeap, dwFlags, dwBytes);
+    }
+
+    // errno belongs to the caller's CRT (ucrtbase), not the one linked in to the fix
+    void SetCrtErrno(int error)
+    {
+        if (oErrno)
+            *oErrno() = error;
+    }
+
+    // Release hooks, installed process-wide since any module sharing ucrtbase or the process heap may free an arena block.
+    // Blocks from before the hooks were installed, or too large for a size class, stay with the original heap.
+    void* __cdecl Realloc_Hook(void* ptr, std::size_t size)
+    {
+        if (!Owns(ptr))
+            return oRealloc(ptr, size);
+
+        if (!size) {
+            Deallocate(ptr);
+            return nullptr;
+        }
+        return Reallocate(ptr, size, oMalloc);
+    }
+
+    void* __cdecl Recalloc_Hook(void* ptr, std::size_t count, std::size_t size)
+    {
+        if (!Owns(ptr))
+            return oRecalloc(ptr, count, size);
+
+        if (size && count > SIZE_MAX / size) {
+            SetCrtErrno(ENOMEM);
+            return nullptr;
+        }
+        if (!count || !size) {
+            Deallocate(ptr);
+            return nullptr;
+        }
+        return Reallocate(ptr, count * size, oMalloc, true);
+    }
+
+    void* __cdecl Expand_Hook(void* ptr, std::size_t size)
+    {
+        if (!Owns(ptr))
+            return oExpand(ptr, size);
+
+        if (size > BlockCapacity(ptr)) {
+            SetCrtErrno(ENOMEM);
+            return nullptr;
+        }
+        BlockSize(ptr) = static_cast<std::uint16_t>(size);
+        return ptr;
+    }
+
+    void __cdecl Free_Hook(void* ptr)
+    {
+        if (Owns(ptr))
+            Deallocate(ptr);
+        else
+            oFree(ptr);
+    }
+
+    std::size_t __cdecl Msize_Hook(void* ptr)
+    {
+        return Owns(ptr) ? BlockSize(ptr) : oMsize(ptr);
+    }
+
+    void* __cdecl ProcessHeapAlloc(std::size_t size)
+    {
+        return oHeapAlloc(hProcessHeap, 0, size);
+    }
+
+    PVOID NTAPI RtlReAllocateHeap_Hook(PVOID hHeap, ULONG dwFlags, PVOID lpMem, SIZE_T dwBytes)
+    {
+        if (!Owns(lpMem))
+            return oRtlReAllocateHeap(hHeap, dwFlags, lpMem, dwBytes);
+
+        bool bZeroTail = (dwFlags & HEAP_ZERO_MEMORY) != 0;
+        if (dwFlags & HEAP_REALLOC_IN_PLACE_ONLY) {
+            if (dwBytes > BlockCapacity(lpMem))
+                return nullptr;
+
+            std::size_t oldSize = BlockSize(lpMem);
+            if (bZeroTail && dwBytes > oldSize)
+                memset((std::uint8_t*)lpMem + oldSize, 0, dwBytes - oldSize);
+            BlockSize(lpMem) = static_cast<std::uint16_t>(dwBytes);
+            return lpMem;
+        }
+        return Reallocate(lpMem, dwBytes, ProcessHeapAlloc, bZeroTail);
+    }
+
+    BOOLEAN NTAPI RtlFreeHeap_Hook(PVOID hHeap, ULONG dwFlags, PVOID lpMem)
+    {
+        if (!Owns(lpMem))
+            return oRtlFreeHeap(hHeap, dwFlags, lpMem);
+
+        Deallocate(lpMem);
+        return TRUE;
+    }
+
+    SIZE_T NTAPI RtlSizeHeap_Hook(PVOID hHeap, ULONG dwFlags, LPCVOID lpMem)
+    {
+        return Owns(lpMem) ? BlockSize(lpMem) : oRtlSizeHeap(hHeap, dwFlags, lpMem);
+    }
+
+    bool Initialise()
+    {
+        if (ArenaBase)
+            return true;
+
+        for (std::size_t cls = 0; cls < kNumClasses; cls++) {
+            if (cls < 8) {
+                ClassSize[cls] = static_cast<std::uint32_t>((cls + 1) * 16);
+            }
+            else {
+                std::size_t group = (cls - 8) / 4;
+                std::size_t step = (cls - 8) % 4;
+                ClassSize[cls] = static_cast<std::uint32_t>((128ull << group) + (step + 1) * (32ull << group));
+            }
+            ClassBatch[cls] = std::clamp<std::uint32_t>(8192 / ClassSize[cls], 2, 64);
+        }
+
+        FlsIndex = FlsAlloc(ThreadExit);
+        if (FlsIndex == FLS_OUT_OF_INDEXES)
+            return false;
+
+        RequestedSizes = (std::uint16_t*)VirtualAlloc(nullptr, kMaxSpans * kSpanSizesBytes, MEM_RESERVE, PAGE_NOACCESS);
+        if (!RequestedSizes)
+            return false;
+
+        ArenaBase = (std::uint8_t*)VirtualAlloc(nullptr, kArenaSize, MEM_RESERVE, PAGE_NOACCESS);
+        return ArenaBase != nullptr;
+    }
+
+    struct Stats
+    {
+        std::uint64_t committedBytes = 0;
+        std::uint64_t inUseBytes = 0;
+        std::uint64_t centralFreeBytes = 0;
+        std::uint64_t lockAcquires = 0;
+        std::uint64_t lockContended = 0;
+
+        struct Class
+        {
+            std::uint32_t size;
+            std::uint64_t spans;
+            std::uint64_t blocksInUse;
+            std::uint64_t lockAcquires;
+            std::uint64_t lockContended;
+        };
+        std::vector<Class> classes;
+    };
+
+    // Blocks sitting in thread caches count as in use
+    Stats GetStats()
+    {
+        Stats stats;
+        for (std::size_t cls = 0; cls < kNumClasses; cls++) {
+            auto& central = Central[cls];
+            std::uint64_t spans = central.spans.load(std::memory_order_relaxed);
+            if (!spans)
+                continue;
+
+            std::uint64_t out = central.blocksOut.load(std::memory_order_relaxed);
+            std::uint64_t in = central.blocksIn.load(std::memory_order_relaxed);
+            std::uint64_t inUse = out > in ? out - in : 0;
+
+            Stats::Class entry{ ClassSize[cls], spans, inUse,
+                central.lockAcquires.load(std::memory_order_relaxed),
+                central.lockContended.load(std::memory_order_relaxed) };
+
+            stats.committedBytes += spans * kSpanSize;
+            stats.inUseBytes += inUse * entry.size;
+            stats.lockAcquires += entry.lockAcquires;
+            stats.lockContended += entry.lockContended;
+            stats.classes.push_back(entry);
+        }
+        stats.centralFreeBytes = stats.committedBytes - stats.inUseBytes;
+        return stats;
+    }
+
+    enum class HookStatus
+    {
+        Installed,
+        NotImported,
+        Skipped,
+        Failed,
+    };
+
+    struct HookResult
+    {
+        std::string name;
+        HookStatus status;
+        std::size_t rva = 0; // Offset of the patched function or IAT slot in its module
+    };
+
+    struct Hook
+    {
+        const char* module;
+        const char* function;
+        void** original;
+        void* detour;
+    };
+
+    // Never destroyed: unhooking on process detach would hand arena blocks still reachable through the IAT to the real heap
+    static auto* ReleaseHooks = new std::vector<SafetyHookInline>;
+
+    // Resolves an export the same way the loader bound the game's import
+    void* ResolveImport(const char* module, const char* function)
+    {
+        HMODULE hModule = GetModuleHandleA(module);
+        return hModule ? (void*)GetProcAddress(hModule, function) : nullptr;
+    }
+
+    // The original pointer is set before the hook is enabled, other threads may call the detour immediately
+    HookResult HookInline(const Hook& hook)
+    {
+        HookResult result{ std::format("{}!{}", hook.module, hook.function), HookStatus::Failed };
+
+        void* target = ResolveImport(hook.module, hook.function);
+        if (!target)
+            return result;
+
+        auto inlineHook = safetyhook::create_inline(target, hook.detour, SafetyHookInline::StartDisabled);
+        if (!inlineHook)
+            return result;
+
+        *hook.original = inlineHook.original<void*>();
+        if (!inlineHook.enable())
+            return result;
+
+        ReleaseHooks->push_back(std::move(inlineHook));
+        result.status = HookStatus::Installed;
+        result.rva = (std::uint8_t*)target - (std::uint8_t*)GetModuleHandleA(hook.module);
+        return result;
+    }
+
+    HookResult HookImport(HMODULE module, const Hook& hook)
+    {
+        HookResult result{ std::format("{}!{}", hook.module, hook.function), HookStatus::NotImported };
+
+        // The CRT may be imported through the API set or directly from ucrtbase
+        std::vector<const char*> importModules = { hook.module };
+        if (Util::string_cmp_caseless(hook.module, "ucrtbase.dll"))
+            importModules.insert(importModules.begin(), "api-ms-win-crt-heap-l1-1-0.dll");
+
+        for (const char* importModule : importModules) {
+            void** thunk = Memory::FindIAT(module, importModule, *hook.original);
+            if (!thunk)
+                continue;
+
+            result.rva = (std::uint8_t*)thunk - (std::uint8_t*)module;
+            result.status = Memory::HookIAT(module, importModule, *hook.original, hook.detour) ? HookStatus::Installed : HookStatus::Failed;
+            if (result.status == HookStatus::Installed)
+                break;
+        }
+        return result;
+    }
+
+    // Release functions are inline hooked process-wide before any allocation is redirected, so an arena block never reaches the original heap.
+    // HeapAlloc is only redirected in the game's IAT if every ntdll release function was hooked. malloc/calloc also need the ucrtbase
+    // release functions, since CRT blocks can be freed through either ucrtbase or straight through the heap (e.g. a statically linked CRT).
+    std::vector<HookResult> Install(HMODULE module)
+    {
+        std::vector<Hook> crtRelease = {
+            { "ucrtbase.dll", "free", (void**)&oFree, (void*)Free_Hook },
+            { "ucrtbase.dll", "realloc", (void**)&oRealloc, (void*)Realloc_Hook },
+            { "ucrtbase.dll", "_recalloc", (void**)&oRecalloc, (void*)Recalloc_Hook },
+            { "ucrtbase.dll", "_expand", (void**)&oExpand, (void*)Expand_Hook },
+            { "ucrtbase.dll", "_msize", (void**)&oMsize, (void*)Msize_Hook },
+        };
+        std::vector<Hook> crtAlloc = {
+            { "ucrtbase.dll", "malloc", (void**)&oMalloc, (void*)Malloc_Hook },
+            { "ucrtbase.dll", "calloc", (void**)&oCalloc, (void*)Calloc_Hook },
+        };
+        std::vector<Hook> heapRelease = {
+            { "ntdll.dll", "RtlFreeHeap", (void**)&oRtlFreeHeap, (void*)RtlFreeHeap_Hook },
+            { "ntdll.dll", "RtlReAllocateHeap", (void**)&oRtlReAllocateHeap, (void*)RtlReAllocateHeap_Hook },
+            { "ntdll.dll", "RtlSizeHeap", (void**)&oRtlSizeHeap, (void*)RtlSizeHeap_Hook },
+        };
+        std::vector<Hook> heapAlloc = {
+            { "kernel32.dll", "HeapAlloc", (void**)&oHeapAlloc, (void*)HeapAlloc_Hook },
+        };
+
+        std::vector<HookResult> results;
+        hProcessHeap = GetProcessHeap();
+
+        // Allocation originals are the functions bound in the IAT, resolved up front since the hooks fall back to them
+        oMalloc = (malloc_t)ResolveImport("ucrtbase.dll", "malloc");
+        oCalloc = (calloc_t)ResolveImport("ucrtbase.dll", "calloc");
+        oHeapAlloc = (HeapAlloc_t)ResolveImport("kernel32.dll", "HeapAlloc");
+        oErrno = (crterrno_t)ResolveImport("ucrtbase.dll", "_errno");
+        ReleaseHooks->reserve(crtRelease.size() + heapRelease.size());
+        if (!oMalloc || !oCalloc || !oHeapAlloc || !Initialise())
+            return results;
+
+        auto installRelease = [&](const std::vector<Hook>& release) {
+            bool bReleaseHooked = true;
+            for (const auto& hook : release) {
+                results.push_back(HookInline(hook));
+                bReleaseHooked &= results.back().status == HookStatus::Installed;
+            }
+            return bReleaseHooked;
+        };
+        auto installAlloc = [&](const std::vector<Hook>& alloc, bool bReleaseHooked) {
+            for (const auto& hook : alloc) {
+                if (bReleaseHooked)
+                    results.push_back(HookImport(module, hook));
+                else
+                    results.push_back({ std::format("{}!{}", hook.module, hook.function), HookStatus::Skipped });
+            }
+        };
+
+        bool bHeapReleaseHooked = installRelease(heapRelease);
+        bool bCrtReleaseHooked = installRelease(crtRelease);
+        installAlloc(heapAlloc, bHeapReleaseHooked);
+        installAlloc(crtAlloc, bCrtReleaseHooked && bHeapReleaseHooked);
+        return results;
+    }
+}
@@ -1,5 +1,8 @@
 ﻿#include "stdafx.h"
 #include "helper.hpp"
+#include "allocator.hpp"
+#include "telemetry.hpp"
+#include "startuptrace.hpp"
 
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/basic_file_sink.h>
@@ -20,6 +23,14 @@ std::filesystem::path sFixPath;
 inipp::Ini<char> ini;
 std::string sConfigFile = sFixName + ".ini";
 
+// Signature hints
+inipp::Ini<char> signatureHints;
+std::string sSignatureHintsFile = sFixName + "_Signatures.ini";
+bool bSignatureHintsChanged = false;
+
+// Startup report
+std::string sStartupReportFile = sFixName + "_Startup.json";
+
 // Logger
 std::shared_ptr<spdlog::logger> logger;
 std::string sLogFile = sFixName + ".log";
@@ -47,6 +58,9 @@ bool bFixHUD;
 bool bFixMovies;
 bool bAdjustFramerate;
 int iFramerateTarget;
+bool bHeapAllocator;
+int iHeapStatsInterval;
+bool bTelemetry;
 
 // Variables
 const float fLetterboxAspect = 2.35f;
@@ -55,6 +69,19 @@ int iCurrentResY;
 std::string sMovieName;
 bool bLetterboxedMovie = false;
 
+// Hooks that only have an effect at certain aspect ratios
+struct AspectHook
+{
+    SafetyHookMid* hook;
+    bool (*isNeeded)();
+    void (*onDisarm)();
+};
+std::vector<AspectHook> AspectHooks;
+std::mutex AspectHooksMutex;
+
+bool IsNarrower() { return fAspectRatio < fNativeAspect; }
+bool IsNotNative() { return fAspectRatio != fNativeAspect; }
+
 void CalculateAspectRatio(bool bLog)
 {
     if (iCurrentResX <= 0 || iCurrentResY <= 0)
@@ -76,6 +103,18 @@ void CalculateAspectRatio(bool bLog)
         fHUDHeightOffset = (float)(iCurrentResY - fHUDHeight) / 2.00f;
     }
 
+    // Publish to telemetry
+    Telemetry::Update([](Telemetry::State& state) {
+        state.resX = iCurrentResX;
+        state.resY = iCurrentResY;
+        state.aspectRatio = fAspectRatio;
+        state.aspectMultiplier = fAspectMultiplier;
+        state.hudWidth = fHUDWidth;
+        state.hudHeight = fHUDHeight;
+        state.hudWidthOffset = fHUDWidthOffset;
+        state.hudHeightOffset = fHUDHeightOffset;
+    });
+
     // Log details about current resolution
     if (bLog) {
         spdlog::info("----------");
@@ -90,6 +129,50 @@ void CalculateAspectRatio(bool bLog)
     }
 }
 
+void ArmAspectHook(const AspectHook& aspectHook)
+{
+    bool bNeeded = aspectHook.isNeeded();
+    if (bNeeded == aspectHook.hook->enabled())
+        return;
+
+    if (bNeeded) {
+        if (!aspectHook.hook->enable())
+            spdlog::error("Aspect Hooks: Failed to enable hook at {:s}+{:x}", sExeName.c_str(), aspectHook.hook->target_address() - (uintptr_t)exeModule);
+    }
+    else {
+        if (!aspectHook.hook->disable())
+            spdlog::error("Aspect Hooks: Failed to disable hook at {:s}+{:x}", sExeName.c_str(), aspectHook.hook->target_address() - (uintptr_t)exeModule);
+        else if (aspectHook.onDisarm)
+            aspectHook.onDisarm();
+    }
+}
+
+void UpdateAspectHooks()
+{
+    std::scoped_lock lock(AspectHooksMutex);
+    for (const auto& aspectHook : AspectHooks)
+        ArmAspectHook(aspectHook);
+
+    auto iArmed = std::ranges::count_if(AspectHooks, [](const AspectHook& aspectHook) { return aspectHook.hook->enabled(); });
+    spdlog::info("Aspect Hooks: {} of {} hooks armed for aspect ratio {}", iArmed, AspectHooks.size(), fAspectRatio);
+    Telemetry::RefreshHooks();
+}
+
+// Hooks stay armed until the current resolution is known, then follow it.
+// Hooks that failed to create are left out, as an empty hook reports success when toggled.
+void RegisterAspectHook(SafetyHookMid* hook, bool (*isNeeded)(), void (*onDisarm)() = nullptr)
+{
+    if (!*hook)
+        return;
+
+    std::scoped_lock lock(AspectHooksMutex);
+    AspectHooks.push_back({ hook, isNeeded, onDisarm });
+    if (iCurrentResX > 0 && iCurrentResY > 0) {
+        ArmAspectHook(AspectHooks.back());
+        Telemetry::RefreshHooks();
+    }
+}
+
 void Logging()
 {
     // Get path to DLL
@@ -108,7 +191,7 @@ void Logging()
     // Spdlog initialisation
     try
     {
-        logger = spdlog::basic_logger_st(sFixName, sExePath.string() + sLogFile, true);
+        logger = spdlog::basic_logger_mt(sFixName, sExePath.string() + sLogFile, true);
         spdlog::set_default_logger(logger);
         spdlog::flush_on(spdlog::level::debug);
 
@@ -169,6 +252,9 @@ void Configuration()
     inipp::get_value(ini.sections["Fix Movies"], "Enabled", bFixMovies);
     inipp::get_value(ini.sections["Framerate"], "Enabled", bAdjustFramerate);
     inipp::get_value(ini.sections["Framerate"], "FramerateTarget", iFramerateTarget);
+    inipp::get_value(ini.sections["Telemetry"], "Enabled", bTelemetry);
+    inipp::get_value(ini.sections["Heap Allocator"], "Enabled", bHeapAllocator);
+    inipp::get_value(ini.sections["Heap Allocator"], "StatsInterval", iHeapStatsInterval);
 
     // Log ini parse
     spdlog_confparse(bCustomRes);
@@ -180,10 +266,89 @@ void Configuration()
     spdlog_confparse(bFixMovies);
     spdlog_confparse(bAdjustFramerate);
     spdlog_confparse(iFramerateTarget);
+    spdlog_confparse(bTelemetry);
+    spdlog_confparse(bHeapAllocator);
+    spdlog_confparse(iHeapStatsInterval);
 
     spdlog::info("----------");
 }
 
+void LoadSignatureHints()
+{
+    // RVAs of each signature from the previous run, used as a starting point for scans
+    std::ifstream hintsFile(sExePath / sSignatureHintsFile);
+    if (hintsFile) {
+        signatureHints.parse(hintsFile);
+        spdlog::info("Signature Hints: Loaded {} hints from {}", signatureHints.sections["Signatures"].size(), sSignatureHintsFile);
+    }
+}
+
+void SaveSignatureHints()
+{
+    if (!bSignatureHintsChanged)
+        return;
+
+    std::ofstream hintsFile(sExePath / sSignatureHintsFile, std::ios::trunc);
+    if (hintsFile) {
+        hintsFile << "; Generated by " << sFixName << ". Safe to delete." << std::endl;
+        signatureHints.generate(hintsFile);
+        spdlog::info("Signature Hints: Saved to {}", sSignatureHintsFile);
+    }
+    else {
+        spdlog::error("Signature Hints: Failed to write {}", sSignatureHintsFile);
+    }
+}
+
+std::uint8_t* ScanSignature(const char* name, const char* signature)
+{
+    auto& hints = signatureHints.sections["Signatures"];
+
+    // Without a hint this is a plain scan of the image
+    std::size_t hintOffset = SIZE_MAX;
+    if (auto hint = hints.find(name); hint != hints.end()) {
+        try {
+            hintOffset = std::stoull(hint->second, nullptr, 16);
+        }
+        catch (const std::exception&) {
+            spdlog::warn("Signature Hints: Ignoring invalid hint for {}: {}", name, hint->second);
+        }
+    }
+
+    std::size_t bytesScanned = 0;
+    auto start = StartupTrace::Clock::now();
+    std::uint8_t* result = Memory::PatternScanNear(exeModule, signature, hintOffset, &bytesScanned);
+    auto duration = StartupTrace::Clock::now() - start;
+
+    std::optional<std::size_t> rva;
+    if (result) {
+        rva = result - (std::uint8_t*)exeModule;
+        if (*rva != hintOffset) {
+            hints[name] = std::format("{:x}", *rva);
+            bSignatureHintsChanged = true;
+        }
+    }
+
+    StartupTrace::AddScan(name, bytesScanned, duration, hintOffset != SIZE_MAX, rva);
+    return result;
+}
+
+// Records a hook in the startup report and publishes it to telemetry
+void RegisterHook(const char* name, SafetyHookMid* hook)
+{
+    std::size_t rva = *hook ? hook->target_address() - (uintptr_t)exeModule : 0;
+    StartupTrace::AddHook(name, rva, static_cast<bool>(*hook));
+    Telemetry::RegisterHook(name, hook);
+}
+
+void WriteStartupReport()
+{
+    // Machine-readable summary of startup timing, scans and hooks
+    if (StartupTrace::Write(sExePath / sStartupReportFile, sFixName, sFixVersion, Memory::ModuleTimestamp(exeModule)))
+        spdlog::info("Startup Report: Written to {} ({} failures)", sStartupReportFile, StartupTrace::Failures.size());
+    else
+        spdlog::error("Startup Report: Failed to write {}", sStartupReportFile);
+}
+
 void CustomResolution()
 {
     if (bCustomRes) 
@@ -198,7 +363,7 @@ void CustomResolution()
         }
 
         // Resolution list
-        std::uint8_t* ResolutionListScanResult = Memory::PatternScan(exeModule, "00 1E 00 00 E0 10 00 00 00 14 00 00 70 08 00 00");
+        std::uint8_t* ResolutionListScanResult = ScanSignature("Resolution List", "00 1E 00 00 E0 10 00 00 00 14 00 00 70 08 00 00");
         if (ResolutionListScanResult) {
             spdlog::info("Resolution List: Address is {:s}+{:x}", sExeName.c_str(), ResolutionListScanResult - (std::uint8_t*)exeModule);
 
@@ -216,7 +381,7 @@ void CustomResolution()
         }
 
         // Resolution string
-        std::uint8_t* ResolutionStringScanResult = Memory::PatternScan(exeModule, "83 ?? 0D 0F 87 ?? ?? ?? ?? 48 8D ?? ?? ?? ?? ?? 48 ?? 8B ?? ?? ?? ?? ?? ?? 48 03 ?? FF ?? 4C 8B ?? ?? ?? ?? ??");
+        std::uint8_t* ResolutionStringScanResult = ScanSignature("Resolution String", "83 ?? 0D 0F 87 ?? ?? ?? ?? 48 8D ?? ?? ?? ?? ?? 48 ?? 8B ?? ?? ?? ?? ?? ?? 48 03 ?? FF ?? 4C 8B ?? ?? ?? ?? ??");
         if (ResolutionStringScanResult) {
             spdlog::info("Resolution String: Address is {:s}+{:x}", sExeName.c_str(), ResolutionStringScanResult - (std::uint8_t*)exeModule);
             static SafetyHookMid ResolutionStringMidHook{};
@@ -235,6 +400,7 @@ void CustomResolution()
                         }
                     }
                 });
+            RegisterHook("Resolution String", &ResolutionStringMidHook);
         }
         else {
             spdlog::error("Resolution String: Pattern scan failed.");
@@ -245,7 +411,7 @@ void CustomResolution()
 void CurrentResolution()
 {
     // Current resolution
-    std::uint8_t* CurrentResolutionScanResult = Memory::PatternScan(exeModule, "49 89 ?? ?? ?? ?? ?? 41 8B ?? ?? ?? ?? ?? ?? 41 89 ?? ?? ?? ?? ?? 4B ?? ?? ?? 49 89 ?? ?? ?? ?? ??");
+    std::uint8_t* CurrentResolutionScanResult = ScanSignature("Current Resolution", "49 89 ?? ?? ?? ?? ?? 41 8B ?? ?? ?? ?? ?? ?? 41 89 ?? ?? ?? ?? ?? 4B ?? ?? ?? 49 89 ?? ?? ?? ?? ??");
     if (CurrentResolutionScanResult) {
         spdlog::info("Current Resolution: Address is {:s}+{:x}", sExeName.c_str(), CurrentResolutionScanResult - (std::uint8_t*)exeModule);
         static SafetyHookMid CurrentResolutionMidHook{};
@@ -255,13 +421,19 @@ void CurrentResolution()
                   int iResX = static_cast<int>(ctx.rcx & 0xFFFFFFFF);
                   int iResY = static_cast<int>((ctx.rcx >> 32) & 0xFFFFFFFF);
   
+                  // Counted as a frame in telemetry, see Telemetry::Counters
+                  Telemetry::Frame();
+
                   // Log resolution
                   if (iResX != iCurrentResX || iResY != iCurrentResY) {
                       iCurrentResX = iResX;
                       iCurrentResY = iResY;
                       CalculateAspectRatio(true);
+                      UpdateAspectHooks();
+                      Telemetry::Count(&Telemetry::Counters::resolutionChanges);
                   }
             });
+        RegisterHook("Current Resolution", &CurrentResolutionMidHook);
     }
     else {
         spdlog::error("Current Resolution: Pattern scan failed.");
@@ -273,7 +445,7 @@ void FOV()
     if (fGameplayFOVMulti != 1.00f) 
     {
         // Gameplay FOV
-        std::uint8_t* GameplayFOVScanResult = Memory::PatternScan(exeModule, "F3 0F ?? ?? ?? 48 8B ?? E8 ?? ?? ?? ?? F3 0F ?? ?? ?? ?? ?? ?? 45 ?? ?? ?? F3 44 ?? ?? ?? ?? ?? ?? ??");
+        std::uint8_t* GameplayFOVScanResult = ScanSignature("Gameplay FOV", "F3 0F ?? ?? ?? 48 8B ?? E8 ?? ?? ?? ?? F3 0F ?? ?? ?? ?? ?? ?? 45 ?? ?? ?? F3 44 ?? ?? ?? ?? ?? ?? ??");
         if (GameplayFOVScanResult) {
             spdlog::info("Gameplay FOV: Address is {:s}+{:x}", sExeName.c_str(), GameplayFOVScanResult - (std::uint8_t*)exeModule);
             static SafetyHookMid GameplayFOVMidHook{};
@@ -281,6 +453,7 @@ void FOV()
                 [](SafetyHookContext& ctx) {
                     ctx.xmm0.f32[0] *= fGameplayFOVMulti;
                 });
+            RegisterHook("Gameplay FOV", &GameplayFOVMidHook);
         }
         else {
             spdlog::error("Gameplay FOV: Pattern scan failed.");
@@ -290,8 +463,8 @@ void FOV()
     if (bFixFOV) 
     {
         // Cutscene camera
-        std::uint8_t* CutsceneFOVScanResult = Memory::PatternScan(exeModule, "E8 ?? ?? ?? ?? 83 ?? 01 75 ?? F3 0F ?? ?? ?? ?? ?? ?? EB ??");
-        std::uint8_t* CutsceneCameraPositionScanResult = Memory::PatternScan(exeModule, "74 ?? 83 ?? FF E8 ?? ?? ?? ?? EB ?? E8 ?? ?? ?? ?? 84 ?? 74 ?? E8 ?? ?? ?? ??");
+        std::uint8_t* CutsceneFOVScanResult = ScanSignature("Cutscene Camera: FOV", "E8 ?? ?? ?? ?? 83 ?? 01 75 ?? F3 0F ?? ?? ?? ?? ?? ?? EB ??");
+        std::uint8_t* CutsceneCameraPositionScanResult = ScanSignature("Cutscene Camera: Position", "74 ?? 83 ?? FF E8 ?? ?? ?? ?? EB ?? E8 ?? ?? ?? ?? 84 ?? 74 ?? E8 ?? ?? ?? ??");
         if (CutsceneFOVScanResult && CutsceneCameraPositionScanResult) {
             spdlog::info("Cutscene Camera: FOV: Address is {:s}+{:x}", sExeName.c_str(), CutsceneFOVScanResult - (std::uint8_t*)exeModule);
             Memory::PatchBytes(CutsceneFOVScanResult + 0x8, "\x90\x90", 2);
@@ -321,7 +494,7 @@ void Movies()
         };
 
         // Movie name
-        std::uint8_t* MovieNameScanResult = Memory::PatternScan(exeModule, "48 8D ?? ?? ?? E8 ?? ?? ?? ?? B8 01 00 00 00 8B ?? 87 ?? ?? 8B ??");
+        std::uint8_t* MovieNameScanResult = ScanSignature("Movies: Name", "48 8D ?? ?? ?? E8 ?? ?? ?? ?? B8 01 00 00 00 8B ?? 87 ?? ?? 8B ??");
         if (MovieNameScanResult) {
             spdlog::info("Movies: Name: Address is {:s}+{:x}", sExeName.c_str(), MovieNameScanResult - (std::uint8_t*)exeModule);
             static SafetyHookMid MovieNameMidHook{};
@@ -335,13 +508,20 @@ void Movies()
                     bLetterboxedMovie = std::ranges::none_of(sNonLetterboxedMovies, [&](const std::string& movie) {
                         return sMovieName.find(movie) != std::string::npos;
                     });
+
+                    Telemetry::Update([](Telemetry::State& state) {
+                        strncpy_s(state.movieName, sMovieName.c_str(), _TRUNCATE);
+                        state.movieLetterboxed = bLetterboxedMovie;
+                    });
+                    Telemetry::Count(&Telemetry::Counters::moviesPlayed);
                 }
             });
+            RegisterHook("Movies: Name", &MovieNameMidHook);
         }
 
         // Movies
-        std::uint8_t* MovieSizeScanResult = Memory::PatternScan(exeModule, "F3 0F ?? ?? ?? ?? 48 8D ?? ?? ?? 48 89 ?? ?? ?? 48 8D ?? ?? ?? C7 ?? ?? ?? 00 00 80 3F");
-        std::uint8_t* MovieAspectScanResult = Memory::PatternScan(exeModule, "F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? E8 ?? ?? ?? ?? 0F ?? ?? ?? 4D ?? ??");
+        std::uint8_t* MovieSizeScanResult = ScanSignature("Movies: Size", "F3 0F ?? ?? ?? ?? 48 8D ?? ?? ?? 48 89 ?? ?? ?? 48 8D ?? ?? ?? C7 ?? ?? ?? 00 00 80 3F");
+        std::uint8_t* MovieAspectScanResult = ScanSignature("Movies: Aspect Ratio", "F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? ?? ?? F3 0F ?? ?? ?? ?? E8 ?? ?? ?? ?? 0F ?? ?? ?? 4D ?? ??");
         if (MovieSizeScanResult && MovieAspectScanResult) {
             spdlog::info("Movies: Size: Address is {:s}+{:x}", sExeName.c_str(), MovieSizeScanResult - (std::uint8_t*)exeModule);
             static SafetyHookMid MovieSizeMidHook{};
@@ -354,6 +534,8 @@ void Movies()
                         ctx.xmm1.f32[0] = 1.00f;
                 }
             });
+            RegisterAspectHook(&MovieSizeMidHook, IsNotNative);
+            RegisterHook("Movies: Size", &MovieSizeMidHook);
 
             spdlog::info("Movies: Aspect Ratio: Address is {:s}+{:x}", sExeName.c_str(), MovieAspectScanResult - (std::uint8_t*)exeModule);
             static SafetyHookMid MovieAspectMidHook{};
@@ -366,6 +548,8 @@ void Movies()
                         ctx.xmm1.f32[0] = fNativeAspect;
                 }  
             });
+            RegisterAspectHook(&MovieAspectMidHook, IsNotNative);
+            RegisterHook("Movies: Aspect Ratio", &MovieAspectMidHook);
         }
         else {
             spdlog::error("Movies: Size: Pattern scan(s) failed.");
@@ -378,7 +562,7 @@ void HUD()
     if (bFixHUD) 
     {
         // Cutscene letterboxing
-        std::uint8_t* CutsceneLetterboxingScanResult = Memory::PatternScan(exeModule, "34 01 48 8D ?? ?? ?? 44 ?? ?? 48 8D ?? ?? ?? E8 ?? ?? ?? ?? 4C ?? ?? ?? ??");
+        std::uint8_t* CutsceneLetterboxingScanResult = ScanSignature("HUD: Cutscene Letterboxing", "34 01 48 8D ?? ?? ?? 44 ?? ?? 48 8D ?? ?? ?? E8 ?? ?? ?? ?? 4C ?? ?? ?? ??");
         if (CutsceneLetterboxingScanResult) {
             spdlog::info("HUD: Cutscene Letterboxing: Address is {:s}+{:x}", sExeName.c_str(), CutsceneLetterboxingScanResult - (std::uint8_t*)exeModule);
             static SafetyHookMid CutsceneLetterboxingMidHook{};
@@ -388,15 +572,17 @@ void HUD()
                 if (fAspectRatio < fNativeAspect)
                     ctx.rax = (ctx.rax & ~0xFF) | 0x01;
             });
+            RegisterAspectHook(&CutsceneLetterboxingMidHook, IsNarrower);
+            RegisterHook("HUD: Cutscene Letterboxing", &CutsceneLetterboxingMidHook);
         }
         else {
             spdlog::error("HUD: Cutscene Letterboxing: Pattern scan failed.");
         }  
         
         // HUD height
-        std::uint8_t* HUDHeightScanResult = Memory::PatternScan(exeModule, "F3 0F ?? ?? ?? 48 8B ?? ?? ?? 48 83 ?? ?? 5F E9 ?? ?? ?? ?? CC 48 83 ?? ??");
-        std::uint8_t* MenuHeightScanResult = Memory::PatternScan(exeModule, "F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? ?? ?? ?? ?? 0F ?? ?? 77 ?? 0F ?? ?? 73 ?? 0F ?? ?? 77 ??");
-        std::uint8_t* MarkersHeightScanResult = Memory::PatternScan(exeModule, "F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? ?? 48 83 ?? ?? C3");
+        std::uint8_t* HUDHeightScanResult = ScanSignature("HUD: Height", "F3 0F ?? ?? ?? 48 8B ?? ?? ?? 48 83 ?? ?? 5F E9 ?? ?? ?? ?? CC 48 83 ?? ??");
+        std::uint8_t* MenuHeightScanResult = ScanSignature("HUD: Menu Height", "F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? ?? ?? ?? ?? 0F ?? ?? 77 ?? 0F ?? ?? 73 ?? 0F ?? ?? 77 ??");
+        std::uint8_t* MarkersHeightScanResult = ScanSignature("HUD: Markers Height", "F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? F3 0F ?? ?? ?? ?? ?? ?? F3 0F ?? ?? ?? 48 83 ?? ?? C3");
         if (HUDHeightScanResult && MenuHeightScanResult && MarkersHeightScanResult) {
             static std::uint8_t* HUDHeight = Memory::GetAbsolute(MenuHeightScanResult - 0x4);
 
@@ -414,6 +600,12 @@ void HUD()
                         Memory::Write(HUDHeight, 1080.00f);
                 }
             });
+            RegisterAspectHook(&HUDHeightMidHook, IsNarrower, [] {
+                // Restore the native HUD height
+                if (HUDHeight)
+                    Memory::Write(HUDHeight, 1080.00f);
+            });
+            RegisterHook("HUD: Height", &HUDHeightMidHook);
 
             spdlog::info("HUD: Menu Height: Address is {:s}+{:x}", sExeName.c_str(), MenuHeightScanResult - (std::uint8_t*)exeModule);
             static SafetyHookMid MenuHeight1MidHook{};
@@ -421,14 +613,18 @@ void HUD()
             [](SafetyHookContext& ctx) {
                 if (fAspectRatio < fNativeAspect)
                     ctx.xmm0.f32[0] = ctx.xmm13.f32[0] / 1080.00f;
-            });          
+            });
+            RegisterAspectHook(&MenuHeight1MidHook, IsNarrower);
+            RegisterHook("HUD: Menu Height 1", &MenuHeight1MidHook);
 
             static SafetyHookMid MenuHeight2MidHook{};
             MenuHeight2MidHook = safetyhook::create_mid(MenuHeightScanResult - 0xA8,
             [](SafetyHookContext& ctx) {
                 if (fAspectRatio < fNativeAspect)
                     ctx.xmm6.f32[0] = ctx.xmm11.f32[0] / fNativeAspect;
-            }); 
+            });
+            RegisterAspectHook(&MenuHeight2MidHook, IsNarrower);
+            RegisterHook("HUD: Menu Height 2", &MenuHeight2MidHook);
             
             spdlog::info("HUD: Markers Height: Address is {:s}+{:x}", sExeName.c_str(), MarkersHeightScanResult - (std::uint8_t*)exeModule);
             static SafetyHookMid MarkersHeightMidHook{};
@@ -438,14 +634,16 @@ void HUD()
                     ctx.xmm3.f32[0] += 540.00f;
                     ctx.xmm3.f32[0] -= (1920.00f / fAspectRatio) / 2.00f;
                 }
-            }); 
+            });
+            RegisterAspectHook(&MarkersHeightMidHook, IsNarrower);
+            RegisterHook("HUD: Markers Height", &MarkersHeightMidHook);
         }
         else {
             spdlog::error("HUD: Height: Pattern scan(s) failed.");
         }
 
         // HUD Objects
-        std::uint8_t* HUDObjectsScanResult = Memory::PatternScan(exeModule, "4D ?? ?? 74 ?? 41 ?? ?? ?? F3 0F ?? ?? ?? ?? ?? ?? 41 ?? 01 00 00 00");
+        std::uint8_t* HUDObjectsScanResult = ScanSignature("HUD: Objects", "4D ?? ?? 74 ?? 41 ?? ?? ?? F3 0F ?? ?? ?? ?? ?? ?? 41 ?? 01 00 00 00");
         if (HUDObjectsScanResult) {
             static std::string sHUDObjectName;
             static short iHUDObjectX;
@@ -477,6 +675,8 @@ void HUD()
                         }
                     }
                 });
+            RegisterAspectHook(&HUDObjectsMidHook, [] { return fAspectRatio > 3.55f || fAspectRatio < fNativeAspect; });
+            RegisterHook("HUD: Objects", &HUDObjectsMidHook);
         }
         else {
             spdlog::error("HUD Objects: Pattern scan failed.");
@@ -489,14 +689,15 @@ void Framerate()
     if (bAdjustFramerate) 
     {
         // Framerate target
-        std::uint8_t* FramerateTargetScanResult = Memory::PatternScan(exeModule, "48 83 ?? 03 73 ?? 8B ?? ?? EB ?? 8B ?? 48 8B ?? ?? ?? 48 33 ?? E8 ?? ?? ?? ?? 48 83 ?? ?? C3");
+        std::uint8_t* FramerateTargetScanResult = ScanSignature("Framerate: Target", "48 83 ?? 03 73 ?? 8B ?? ?? EB ?? 8B ?? 48 8B ?? ?? ?? 48 33 ?? E8 ?? ?? ?? ?? 48 83 ?? ?? C3");
         if (FramerateTargetScanResult) {
             spdlog::info("Framerate: Target: Address is {:s}+{:x}", sExeName.c_str(), FramerateTargetScanResult - (std::uint8_t*)exeModule);
             static SafetyHookMid FramerateTargetMidHook{};
             FramerateTargetMidHook = safetyhook::create_mid(FramerateTargetScanResult + 0xD,
             [](SafetyHookContext& ctx) {
                 ctx.rax = iFramerateTarget;
-            });       
+            });
+            RegisterHook("Framerate: Target", &FramerateTargetMidHook);
         }
         else {
             spdlog::error("Framerate: Target: Pattern scan failed.");
@@ -504,16 +705,101 @@ void Framerate()
     }
 }
 
+DWORD __stdcall HeapStats(void*)
+{
+    while (true)
+    {
+        Sleep(iHeapStatsInterval * 1000);
+
+        auto stats = Heap::GetStats();
+        double fFragmentation = stats.committedBytes ? 100.0 * stats.centralFreeBytes / stats.committedBytes : 0.0;
+        double fContention = stats.lockAcquires ? 100.0 * stats.lockContended / stats.lockAcquires : 0.0;
+
+        spdlog::info("Heap Allocator: Committed: {:.2f}MB, In use: {:.2f}MB, Free: {:.2f}MB ({:.1f}% fragmentation)",
+            stats.committedBytes / 1048576.0, stats.inUseBytes / 1048576.0, stats.centralFreeBytes / 1048576.0, fFragmentation);
+        spdlog::info("Heap Allocator: Lock acquisitions: {}, Contended: {} ({:.2f}%)", stats.lockAcquires, stats.lockContended, fContention);
+
+        for (const auto& cls : stats.classes) {
+            spdlog::info("Heap Allocator: Class {}: Spans: {}, Blocks in use: {}, Lock acquisitions: {}, Contended: {}",
+                cls.size, cls.spans, cls.blocksInUse, cls.lockAcquires, cls.lockContended);
+        }
+    }
+
+    return true;
+}
+
+void SharedMemory()
+{
+    if (bTelemetry)
+    {
+        // Publish runtime state for external overlays
+        if (Telemetry::Initialise(sFixVersion)) {
+            spdlog::info("Telemetry: Publishing to shared memory segment {}", Util::wstring_to_string(Telemetry::kMappingName));
+        }
+        else {
+            spdlog::error("Telemetry: Failed to create shared memory segment. Error: {}", GetLastError());
+            StartupTrace::AddFailure("Telemetry: Failed to create shared memory segment.");
+        }
+    }
+}
+
+void HeapAllocator()
+{
+    if (bHeapAllocator)
+    {
+        // Redirect the game's CRT/heap imports to the size-class allocator
+        auto hooks = Heap::Install(exeModule);
+        if (hooks.empty()) {
+            spdlog::error("Heap Allocator: Failed to initialise.");
+            StartupTrace::AddFailure("Heap Allocator: Failed to initialise.");
+            return;
+        }
+
+        for (const auto& hook : hooks) {
+            // Only patch failures are reported, as a skipped hook follows from a release hook failure that was reported already
+            StartupTrace::AddHook(hook.name.c_str(), hook.rva, hook.status == Heap::HookStatus::Installed, hook.status == Heap::HookStatus::Failed);
+            switch (hook.status) {
+            case Heap::HookStatus::Installed:
+                spdlog::info("Heap Allocator: Hooked {}", hook.name);
+                break;
+            case Heap::HookStatus::NotImported:
+                spdlog::info("Heap Allocator: {} is not imported by the game.", hook.name);
+                break;
+            case Heap::HookStatus::Skipped:
+                spdlog::warn("Heap Allocator: Did not hook {} as its release functions could not be hooked.", hook.name);
+                break;
+            case Heap::HookStatus::Failed:
+                spdlog::error("Heap Allocator: Failed to hook {}", hook.name);
+                break;
+            }
+        }
+
+        if (iHeapStatsInterval > 0) {
+            HANDLE statsHandle = CreateThread(NULL, 0, HeapStats, 0, NULL, 0);
+            if (statsHandle)
+            {
+                SetThreadPriority(statsHandle, THREAD_PRIORITY_LOWEST);
+                CloseHandle(statsHandle);
+            }
+        }
+    }
+}
+
 DWORD __stdcall Main(void*)
 {
-    Logging();
-    Configuration();
-    CustomResolution();
-    CurrentResolution();
-    FOV();
-    Movies();
-    HUD();
-    Framerate();
+    StartupTrace::RunPhase("Logging", Logging);
+    StartupTrace::RunPhase("Configuration", Configuration);
+    StartupTrace::RunPhase("LoadSignatureHints", LoadSignatureHints);
+    StartupTrace::RunPhase("SharedMemory", SharedMemory);
+    StartupTrace::RunPhase("HeapAllocator", HeapAllocator);
+    StartupTrace::RunPhase("CustomResolution", CustomResolution);
+    StartupTrace::RunPhase("CurrentResolution", CurrentResolution);
+    StartupTrace::RunPhase("FOV", FOV);
+    StartupTrace::RunPhase("Movies", Movies);
+    StartupTrace::RunPhase("HUD", HUD);
+    StartupTrace::RunPhase("Framerate", Framerate);
+    StartupTrace::RunPhase("SaveSignatureHints", SaveSignatureHints);
+    WriteStartupReport();
 
     return true;
 }
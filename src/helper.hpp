@@ -1,3 +1,5 @@
+#pragma once
+
 #include "stdafx.h"
 
 namespace Memory
@@ -39,34 +41,93 @@ namespace Memory
         return bytes;
     }
 
-    std::uint8_t* PatternScan(void* module, const char* signature) 
+    std::uint8_t* PatternScanRange(std::uint8_t* start, std::size_t count, const std::vector<int>& patternBytes)
     {
-        auto dosHeader = (PIMAGE_DOS_HEADER)module;
-        auto ntHeaders = (PIMAGE_NT_HEADERS)((std::uint8_t*)module + dosHeader->e_lfanew);
-
-        auto sizeOfImage = ntHeaders->OptionalHeader.SizeOfImage;
-        auto patternBytes = pattern_to_byte(signature);
-        auto scanBytes = reinterpret_cast<std::uint8_t*>(module);
-
         auto s = patternBytes.size();
         auto d = patternBytes.data();
 
-        for (auto i = 0ul; i < sizeOfImage - s; ++i) {
+        for (auto i = 0ull; i < count; ++i) {
             bool found = true;
-            for (auto j = 0ul; j < s; ++j) {
-                if (scanBytes[i + j] != d[j] && d[j] != -1) {
+            for (auto j = 0ull; j < s; ++j) {
+                if (start[i + j] != d[j] && d[j] != -1) {
                     found = false;
                     break;
                 }
             }
             if (found) {
-                return &scanBytes[i];
+                return &start[i];
             }
         }
 
         return nullptr;
     }
 
+    std::uint8_t* PatternScan(void* module, const char* signature) 
+    {
+        auto dosHeader = (PIMAGE_DOS_HEADER)module;
+        auto ntHeaders = (PIMAGE_NT_HEADERS)((std::uint8_t*)module + dosHeader->e_lfanew);
+
+        auto sizeOfImage = ntHeaders->OptionalHeader.SizeOfImage;
+        auto patternBytes = pattern_to_byte(signature);
+        auto scanBytes = reinterpret_cast<std::uint8_t*>(module);
+
+        if (sizeOfImage <= patternBytes.size())
+            return nullptr;
+
+        return PatternScanRange(scanBytes, sizeOfImage - patternBytes.size(), patternBytes);
+    }
+
+    // Searches expanding windows around hintOffset (an RVA) before falling back to the rest of the image
+    std::uint8_t* PatternScanNear(void* module, const char* signature, std::size_t hintOffset, std::size_t* bytesScanned = nullptr)
+    {
+        auto dosHeader = (PIMAGE_DOS_HEADER)module;
+        auto ntHeaders = (PIMAGE_NT_HEADERS)((std::uint8_t*)module + dosHeader->e_lfanew);
+
+        auto sizeOfImage = ntHeaders->OptionalHeader.SizeOfImage;
+        auto patternBytes = pattern_to_byte(signature);
+        auto scanBytes = reinterpret_cast<std::uint8_t*>(module);
+
+        std::size_t scanned = 0;
+        auto scanRange = [&](std::size_t offset, std::size_t count) {
+            std::uint8_t* result = PatternScanRange(scanBytes + offset, count, patternBytes);
+            scanned += result ? static_cast<std::size_t>(result - (scanBytes + offset)) + 1 : count;
+            return result;
+        };
+        auto finish = [&](std::uint8_t* result) {
+            if (bytesScanned)
+                *bytesScanned = scanned;
+            return result;
+        };
+
+        if (patternBytes.empty() || sizeOfImage <= patternBytes.size())
+            return finish(nullptr);
+
+        // Range [lo, hi) of start positions already searched
+        std::size_t last = sizeOfImage - patternBytes.size();
+        std::size_t lo = 0;
+        std::size_t hi = 0;
+
+        if (hintOffset < last) {
+            lo = hi = hintOffset;
+            for (std::size_t radius : { 0x1000ull, 0x10000ull, 0x100000ull }) {
+                std::size_t newLo = hintOffset > radius ? hintOffset - radius : 0;
+                std::size_t newHi = (std::min)(hintOffset + radius, last);
+
+                if (auto result = scanRange(hi, newHi - hi))
+                    return finish(result);
+                if (auto result = scanRange(newLo, lo - newLo))
+                    return finish(result);
+
+                lo = newLo;
+                hi = newHi;
+            }
+        }
+
+        if (auto result = scanRange(0, lo))
+            return finish(result);
+        return finish(scanRange(hi, last - hi));
+    }
+
     std::uint8_t* MultiPatternScan(void* module, const std::vector<const char*>& signatures) 
     { 
         for (const auto& signature : signatures) 
@@ -139,7 +200,8 @@ namespace Memory
         return absoluteAddress;
     }
 
-    BOOL HookIAT(HMODULE callerModule, char const* targetModule, const void* targetFunction, void* detourFunction)
+    // Returns the IAT slot in callerModule bound to targetFunction, or nullptr if it isn't imported
+    void** FindIAT(HMODULE callerModule, char const* targetModule, const void* targetFunction)
     {
         auto* base = (uint8_t*)callerModule;
         const auto* dos_header = (IMAGE_DOS_HEADER*)base;
@@ -156,23 +218,28 @@ namespace Memory
 
             for (; *thunk; thunk++)
             {
-                const void* import = *thunk;
+                if (*thunk == targetFunction)
+                    return thunk;
+            }
+        }
+        return nullptr;
+    }
 
-                if (import != targetFunction)
-                    continue;
+    BOOL HookIAT(HMODULE callerModule, char const* targetModule, const void* targetFunction, void* detourFunction)
+    {
+        void** thunk = FindIAT(callerModule, targetModule, targetFunction);
+        if (!thunk)
+            return FALSE;
 
-                DWORD oldState;
-                if (!VirtualProtect(thunk, sizeof(void*), PAGE_READWRITE, &oldState))
-                    return FALSE;
+        DWORD oldState;
+        if (!VirtualProtect(thunk, sizeof(void*), PAGE_READWRITE, &oldState))
+            return FALSE;
 
-                *thunk = detourFunction;
+        *thunk = detourFunction;
 
-                VirtualProtect(thunk, sizeof(void*), oldState, &oldState);
+        VirtualProtect(thunk, sizeof(void*), oldState, &oldState);
 
-                return TRUE;
-            }
-        }
-        return FALSE;
+        return TRUE;
     }
 }
 
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "stdafx.h"
+
+#include <chrono>
+#include <optional>
+
+namespace StartupTrace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Phase
+    {
+        std::string name;
+        double ms;
+    };
+
+    struct Scan
+    {
+        std::string name;
+        std::string phase;
+        std::size_t bytesScanned;
+        double ms;
+        bool bHinted;
+        std::optional<std::size_t> rva;
+    };
+
+    struct Hook
+    {
+        std::string name;
+        std::string phase;
+        std::size_t rva;
+        bool bInstalled;
+    };
+
+    // Starts when the fix is loaded
+    Clock::time_point StartTime = Clock::now();
+    std::string CurrentPhase;
+    std::vector<Phase> Phases;
+    std::vector<Scan> Scans;
+    std::vector<Hook> Hooks;
+    std::vector<std::string> Failures;
+
+    double Milliseconds(Clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    template<typename Fn>
+    void RunPhase(const char* name, Fn&& fn)
+    {
+        CurrentPhase = name;
+        auto start = Clock::now();
+        fn();
+        Phases.push_back({ name, Milliseconds(Clock::now() - start) });
+        CurrentPhase.clear();
+    }
+
+    void AddScan(const char* name, std::size_t bytesScanned, Clock::duration duration, bool bHinted, std::optional<std::size_t> rva)
+    {
+        Scans.push_back({ name, CurrentPhase, bytesScanned, Milliseconds(duration), bHinted, rva });
+        if (!rva)
+            Failures.push_back(std::format("{}: Pattern scan failed.", name));
+    }
+
+    // bReportFailure is cleared for hooks that were deliberately not installed
+    void AddHook(const char* name, std::size_t rva, bool bInstalled, bool bReportFailure = true)
+    {
+        Hooks.push_back({ name, CurrentPhase, rva, bInstalled });
+        if (!bInstalled && bReportFailure)
+            Failures.push_back(std::format("{}: Failed to create hook.", name));
+    }
+
+    void AddFailure(const std::string& failure)
+    {
+        Failures.push_back(failure);
+    }
+
+    std::string Escape(const std::string& str)
+    {
+        std::string escaped;
+        for (char c : str) {
+            switch (c) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if ((unsigned char)c < 0x20)
+                    escaped += std::format("\\u{:04x}", c);
+                else
+                    escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    // Writes the report as JSON, one object per line in each array to keep it diffable
+    bool Write(const std::filesystem::path& path, const std::string& fixName, const std::string& fixVersion, std::uint32_t moduleTimestamp)
+    {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file)
+            return false;
+
+        double fTotalMs = Milliseconds(Clock::now() - StartTime);
+        double fScanMs = 0.0;
+        std::size_t bytesScanned = 0;
+        for (const auto& scan : Scans) {
+            fScanMs += scan.ms;
+            bytesScanned += scan.bytesScanned;
+        }
+
+        auto join = [&](const auto& items, auto&& format) {
+            for (std::size_t i = 0; i < items.size(); i++)
+                file << "    " << format(items[i]) << (i + 1 < items.size() ? ",\n" : "\n");
+        };
+
+        file << "{\n";
+        file << std::format("  \"fix\": \"{}\",\n", Escape(fixName));
+        file << std::format("  \"version\": \"{}\",\n", Escape(fixVersion));
+        file << std::format("  \"moduleTimestamp\": {},\n", moduleTimestamp);
+        file << std::format("  \"totalMs\": {:.3f},\n", fTotalMs);
+        file << std::format("  \"scanMs\": {:.3f},\n", fScanMs);
+        file << std::format("  \"scanBytes\": {},\n", bytesScanned);
+
+        file << "  \"phases\": [\n";
+        join(Phases, [](const Phase& phase) {
+            return std::format("{{ \"name\": \"{}\", \"ms\": {:.3f} }}", Escape(phase.name), phase.ms);
+        });
+        file << "  ],\n";
+
+        file << "  \"scans\": [\n";
+        join(Scans, [](const Scan& scan) {
+            return std::format("{{ \"name\": \"{}\", \"phase\": \"{}\", \"bytes\": {}, \"ms\": {:.3f}, \"hinted\": {}, \"rva\": {} }}",
+                Escape(scan.name), Escape(scan.phase), scan.bytesScanned, scan.ms, scan.bHinted,
+                scan.rva ? std::format("\"0x{:x}\"", *scan.rva) : "null");
+        });
+        file << "  ],\n";
+
+        file << "  \"hooks\": [\n";
+        join(Hooks, [](const Hook& hook) {
+            return std::format("{{ \"name\": \"{}\", \"phase\": \"{}\", \"rva\": \"0x{:x}\", \"installed\": {} }}",
+                Escape(hook.name), Escape(hook.phase), hook.rva, hook.bInstalled);
+        });
+        file << "  ],\n";
+
+        file << "  \"failures\": [\n";
+        join(Failures, [](const std::string& failure) {
+            return std::format("\"{}\"", Escape(failure));
+        });
+        file << "  ]\n";
+        file << "}\n";
+
+        return file.good();
+    }
+}
@@ -7,4 +7,6 @@
 #include <fstream>
 #include <filesystem>
 #include <vector>
-#include <ranges>
\ No newline at end of file
+#include <ranges>
+#include <mutex>
+#include <format>
\ No newline at end of file
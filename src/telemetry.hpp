@@ -0,0 +1,106 @@
+#pragma once
+
+#include "stdafx.h"
+#include "telemetry_layout.hpp"
+
+#include <mutex>
+#include <safetyhook.hpp>
+
+namespace Telemetry
+{
+    Layout* Shared = nullptr;
+    HANDLE hMapping = nullptr;
+
+    // The seqlock allows a single writer at a time, hooks may fire on different game threads
+    std::mutex WriterMutex;
+    std::vector<std::pair<SafetyHookMid*, Hook*>> Hooks;
+
+    bool Initialise(const std::string& fixVersion)
+    {
+        if (Shared)
+            return true;
+
+        hMapping = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, sizeof(Layout), kMappingName);
+        if (!hMapping)
+            return false;
+
+        Shared = static_cast<Layout*>(MapViewOfFile(hMapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(Layout)));
+        if (!Shared) {
+            CloseHandle(hMapping);
+            hMapping = nullptr;
+            return false;
+        }
+
+        // A previous instance may have left the segment behind if a reader kept it open
+        Shared->header.magic.store(0, std::memory_order_relaxed);
+        memset((std::uint8_t*)Shared + sizeof(Header), 0, sizeof(Layout) - sizeof(Header));
+
+        Shared->header.version = kVersion;
+        Shared->header.size = sizeof(Layout);
+        Shared->header.writerProcessId = GetCurrentProcessId();
+        strncpy_s(Shared->header.fixVersion, fixVersion.c_str(), _TRUNCATE);
+        Shared->header.magic.store(kMagic, std::memory_order_release);
+        return true;
+    }
+
+    // Runs fn with the state while readers see an odd sequence
+    template<typename Fn>
+    void Update(Fn&& fn)
+    {
+        if (!Shared)
+            return;
+
+        std::scoped_lock lock(WriterMutex);
+        std::uint32_t sequence = Shared->sequence.load(std::memory_order_relaxed);
+        Shared->sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        fn(Shared->state);
+        Shared->sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    void Frame()
+    {
+        if (!Shared)
+            return;
+
+        LARGE_INTEGER qpc;
+        QueryPerformanceCounter(&qpc);
+        Shared->counters.frames.fetch_add(1, std::memory_order_relaxed);
+        Shared->counters.lastFrameQpc.store(qpc.QuadPart, std::memory_order_relaxed);
+    }
+
+    void Count(std::atomic<std::uint64_t> Counters::* counter)
+    {
+        if (Shared)
+            (Shared->counters.*counter).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Publishes a hook by name so readers can see whether it is active
+    void RegisterHook(const char* name, SafetyHookMid* hook)
+    {
+        if (!Shared)
+            return;
+
+        std::scoped_lock lock(WriterMutex);
+        std::uint32_t index = Shared->hookCount.load(std::memory_order_relaxed);
+        if (index >= kMaxHooks)
+            return;
+
+        Hook* entry = &Shared->hooks[index];
+        strncpy_s(entry->name, name, _TRUNCATE);
+        entry->active.store(hook->enabled(), std::memory_order_relaxed);
+        Shared->hookCount.store(index + 1, std::memory_order_release);
+        Hooks.emplace_back(hook, entry);
+    }
+
+    // Republishes the active state of every registered hook
+    void RefreshHooks()
+    {
+        if (!Shared)
+            return;
+
+        std::scoped_lock lock(WriterMutex);
+        for (auto& [hook, entry] : Hooks)
+            entry->active.store(hook->enabled(), std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+// Layout of the shared-memory telemetry segment.
+// Shared between the fix (writer) and external readers, so it must only depend on the standard library.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Telemetry
+{
+    constexpr const wchar_t* kMappingName = L"Local\\RiseOfTheRoninFixTelemetry";
+    constexpr std::uint32_t kMagic = 0x46525452; // "RTRF"
+    constexpr std::uint32_t kVersion = 1;
+    constexpr std::size_t kCacheLine = 64;
+    constexpr std::size_t kMaxHooks = 32;
+    constexpr std::size_t kHookNameLength = 48;
+    constexpr std::size_t kMovieNameLength = 128;
+
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free && std::atomic<std::uint64_t>::is_always_lock_free,
+        "Shared-memory atomics must be lock free.");
+
+    // Written once before magic is published
+    struct alignas(kCacheLine) Header
+    {
+        std::atomic<std::uint32_t> magic;
+        std::uint32_t version;
+        std::uint32_t size;
+        std::uint32_t writerProcessId;
+        char fixVersion[16];
+    };
+
+    // Protected by Layout::sequence. Readers must copy it out and retry if the sequence changed.
+    struct alignas(kCacheLine) State
+    {
+        std::int32_t resX;
+        std::int32_t resY;
+        float aspectRatio;
+        float aspectMultiplier;
+        float hudWidth;
+        float hudHeight;
+        float hudWidthOffset;
+        float hudHeightOffset;
+        std::uint32_t movieLetterboxed;
+        char movieName[kMovieNameLength];
+    };
+
+    // Monotonic counters, updated without the seqlock.
+    // frames counts calls to the game's current resolution hook and lastFrameQpc is the QueryPerformanceCounter value of the latest call.
+    // This has not been confirmed to run exactly once per frame, so treat it as a frame rate estimate.
+    struct alignas(kCacheLine) Counters
+    {
+        std::atomic<std::uint64_t> frames;
+        std::atomic<std::int64_t> lastFrameQpc;
+        std::atomic<std::uint64_t> resolutionChanges;
+        std::atomic<std::uint64_t> moviesPlayed;
+    };
+
+    // Names are written before hookCount is incremented
+    struct alignas(kCacheLine) Hook
+    {
+        char name[kHookNameLength];
+        std::atomic<std::uint32_t> active;
+    };
+
+    struct Layout
+    {
+        Header header;
+        alignas(kCacheLine) std::atomic<std::uint32_t> sequence;
+        State state;
+        Counters counters;
+        alignas(kCacheLine) std::atomic<std::uint32_t> hookCount;
+        Hook hooks[kMaxHooks];
+    };
+
+    static_assert(sizeof(Hook) == kCacheLine);
+    static_assert(offsetof(Layout, state) % kCacheLine == 0 && offsetof(Layout, counters) % kCacheLine == 0);
+}
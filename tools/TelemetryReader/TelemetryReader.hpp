@@ -0,0 +1,113 @@
+#pragma once
+
+// Reader for the RiseOfTheRoninFix shared-memory telemetry segment.
+// Header-only, include this and link nothing else.
+
+#define WIN32_LEAN_AND_MEAN
+
+#include <windows.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "telemetry_layout.hpp"
+
+namespace TelemetryReader
+{
+    struct Hook
+    {
+        std::string name;
+        bool bActive;
+    };
+
+    struct Snapshot
+    {
+        std::uint32_t writerProcessId;
+        std::string fixVersion;
+        Telemetry::State state;
+        std::uint64_t frames;
+        std::int64_t lastFrameQpc;
+        std::uint64_t resolutionChanges;
+        std::uint64_t moviesPlayed;
+        std::vector<Hook> hooks;
+    };
+
+    struct Connection
+    {
+        HANDLE hMapping = nullptr;
+        const Telemetry::Layout* shared = nullptr;
+    };
+
+    inline void Close(Connection& connection)
+    {
+        if (connection.shared)
+            UnmapViewOfFile(connection.shared);
+        if (connection.hMapping)
+            CloseHandle(connection.hMapping);
+        connection = {};
+    }
+
+    // Fails if the game is not running or the segment was written by an incompatible version of the fix
+    inline bool Open(Connection& connection)
+    {
+        Close(connection);
+
+        connection.hMapping = OpenFileMappingW(FILE_MAP_READ, FALSE, Telemetry::kMappingName);
+        if (!connection.hMapping)
+            return false;
+
+        connection.shared = static_cast<const Telemetry::Layout*>(MapViewOfFile(connection.hMapping, FILE_MAP_READ, 0, 0, sizeof(Telemetry::Layout)));
+        if (!connection.shared) {
+            Close(connection);
+            return false;
+        }
+
+        const auto& header = connection.shared->header;
+        if (header.magic.load(std::memory_order_acquire) != Telemetry::kMagic || header.version != Telemetry::kVersion || header.size != sizeof(Telemetry::Layout)) {
+            Close(connection);
+            return false;
+        }
+        return true;
+    }
+
+    // Takes a consistent copy of the state, retrying while the fix is mid-update
+    inline bool Read(const Connection& connection, Snapshot& snapshot, int maxRetries = 1000)
+    {
+        const auto* shared = connection.shared;
+        if (!shared)
+            return false;
+
+        bool bConsistent = false;
+        for (int i = 0; i < maxRetries && !bConsistent; i++) {
+            std::uint32_t before = shared->sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                YieldProcessor();
+                continue;
+            }
+
+            std::memcpy(&snapshot.state, (const void*)&shared->state, sizeof(Telemetry::State));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            bConsistent = shared->sequence.load(std::memory_order_relaxed) == before;
+        }
+        if (!bConsistent)
+            return false;
+
+        snapshot.state.movieName[Telemetry::kMovieNameLength - 1] = '\0';
+        snapshot.writerProcessId = shared->header.writerProcessId;
+        snapshot.fixVersion.assign(shared->header.fixVersion, strnlen(shared->header.fixVersion, sizeof(shared->header.fixVersion)));
+        snapshot.frames = shared->counters.frames.load(std::memory_order_relaxed);
+        snapshot.lastFrameQpc = shared->counters.lastFrameQpc.load(std::memory_order_relaxed);
+        snapshot.resolutionChanges = shared->counters.resolutionChanges.load(std::memory_order_relaxed);
+        snapshot.moviesPlayed = shared->counters.moviesPlayed.load(std::memory_order_relaxed);
+
+        std::uint32_t hookCount = (std::min)(shared->hookCount.load(std::memory_order_acquire), (std::uint32_t)Telemetry::kMaxHooks);
+        snapshot.hooks.resize(hookCount);
+        for (std::uint32_t i = 0; i < hookCount; i++) {
+            const auto& hook = shared->hooks[i];
+            snapshot.hooks[i].name.assign(hook.name, strnlen(hook.name, Telemetry::kHookNameLength));
+            snapshot.hooks[i].bActive = hook.active.load(std::memory_order_relaxed) != 0;
+        }
+        return true;
+    }
+}
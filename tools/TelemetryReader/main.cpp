@@ -0,0 +1,73 @@
+#include "TelemetryReader.hpp"
+
+#include <iostream>
+#include <format>
+
+// Sample console reader, polls the telemetry segment and redraws in place
+int main()
+{
+    TelemetryReader::Connection connection;
+    TelemetryReader::Snapshot snapshot;
+
+    LARGE_INTEGER qpcFrequency;
+    QueryPerformanceFrequency(&qpcFrequency);
+
+    std::uint64_t lastFrames = 0;
+    LARGE_INTEGER lastPoll{};
+
+    // Enable escape sequences for redrawing
+    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD consoleMode = 0;
+    if (GetConsoleMode(hConsole, &consoleMode))
+        SetConsoleMode(hConsole, consoleMode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
+
+    std::cout << "\x1b[?25l";
+    while (true)
+    {
+        if (!connection.shared && !TelemetryReader::Open(connection)) {
+            std::cout << "\x1b[2J\x1b[HWaiting for RiseOfTheRoninFix..." << std::flush;
+            Sleep(1000);
+            continue;
+        }
+
+        // Reopen if the game was restarted
+        DWORD exitCode = 0;
+        HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, connection.shared->header.writerProcessId);
+        bool bAlive = hProcess && GetExitCodeProcess(hProcess, &exitCode) && exitCode == STILL_ACTIVE;
+        if (hProcess)
+            CloseHandle(hProcess);
+        if (!bAlive || !TelemetryReader::Read(connection, snapshot)) {
+            TelemetryReader::Close(connection);
+            lastFrames = 0;
+            lastPoll = {};
+            continue;
+        }
+
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        double fElapsed = lastPoll.QuadPart ? (double)(now.QuadPart - lastPoll.QuadPart) / qpcFrequency.QuadPart : 0.0;
+        double fFramerate = fElapsed > 0.0 ? (snapshot.frames - lastFrames) / fElapsed : 0.0;
+        lastPoll = now;
+        lastFrames = snapshot.frames;
+
+        const auto& state = snapshot.state;
+        std::string output = "\x1b[2J\x1b[H";
+        output += std::format("RiseOfTheRoninFix v{} (PID {})\n\n", snapshot.fixVersion, snapshot.writerProcessId);
+        output += std::format("Resolution:         {}x{}\n", state.resX, state.resY);
+        output += std::format("Aspect Ratio:       {:.4f} (x{:.4f})\n", state.aspectRatio, state.aspectMultiplier);
+        output += std::format("HUD:                {:.1f}x{:.1f} +{:.1f}+{:.1f}\n", state.hudWidth, state.hudHeight, state.hudWidthOffset, state.hudHeightOffset);
+        output += std::format("Movie:              {} ({})\n", state.movieName[0] ? state.movieName : "-", state.movieLetterboxed ? "letterboxed" : "full");
+        output += std::format("Frames:             {} (~{:.1f} fps, from resolution hook calls)\n", snapshot.frames, fFramerate);
+        output += std::format("Resolution Changes: {}\n", snapshot.resolutionChanges);
+        output += std::format("Movies Played:      {}\n\n", snapshot.moviesPlayed);
+
+        output += "Hooks:\n";
+        for (const auto& hook : snapshot.hooks)
+            output += std::format("  [{}] {}\n", hook.bActive ? "x" : " ", hook.name);
+
+        std::cout << output << std::flush;
+        Sleep(100);
+    }
+
+    return 0;
+}
@@ -21,3 +21,15 @@ set_optimize("faster")
       add_cxflags("/MTd")
     end
   end
+
+  -- Sample telemetry reader, build with "xmake build TelemetryReader"
+  target("TelemetryReader")
+    set_kind("binary")
+    set_default(false)
+    add_files("tools/TelemetryReader/*.cpp")
+    add_includedirs("src")
+
+  if is_plat("windows") then
+    set_toolchains("msvc")
+    add_cxflags("/utf-8")
+  end